@@ -0,0 +1,38 @@
+#ifndef BUILD_CONFIG_H
+#define BUILD_CONFIG_H
+
+#include <stdint.h>
+
+// === 编译期配置 ===
+// 由 platformio.ini 的 build_flags 选择:
+//   默认          : 带 RM67162 屏幕与触摸的 UI 版本
+//   -DSCANNER_HEADLESS=1 : 无屏传感器版本，GFX/触摸代码全部编译掉，
+//                          BLE 双 PHY 满占空比扫描，只通过串口流输出
+#ifndef SCANNER_HEADLESS
+#define SCANNER_HEADLESS 0
+#endif
+
+// 预处理层面的开关 (用于 #include / 全局对象等 constexpr 管不到的地方)
+#define SCANNER_UI (!SCANNER_HEADLESS)
+
+namespace BuildConfig {
+    constexpr bool headless = SCANNER_HEADLESS;
+    constexpr bool hasDisplay = !headless;     // 屏幕 + 触摸 + 绘图
+    constexpr bool streamReports = headless;   // 每条报文通过串口流输出
+
+    // 扫描参数 (单位 0.625ms)，window == interval 即 100% 占空比
+    constexpr uint16_t scanInterval = 40;
+    constexpr uint16_t scanWindow = headless ? 40 : 30;
+
+    // 扫描类型 (使用整数，与 esp_ble_scan_type_t 对应): 0 = 被动，1 = 主动
+    // Remote ID 只需要广播数据，无屏版本用被动扫描，不发 SCAN_REQ 占用射频时间
+    constexpr uint8_t scanType = headless ? 0 : 1;
+
+    // 主循环节拍: UI 约 50Hz 重绘，无屏版本只需及时清空输出队列
+    constexpr uint32_t loopDelayMs = headless ? 2 : 20;
+
+    // 统计行输出周期 (两种版本都输出，用于对比 reports/sec 与丢包率)
+    constexpr uint32_t statPeriodMs = 1000;
+}
+
+#endif
@@ -42,6 +42,7 @@ struct DroneInfo {
     unsigned long lastSeen;
     unsigned long msgCount;
     String debugTypes; // 记录收到了哪些包类型 (0,1,3,4...)
+    int kinSlot;       // 运动学航迹槽位 (Kinematics.h)，-1 表示未跟踪
 };
 
 extern std::vector<DroneInfo> droneList;
@@ -0,0 +1,222 @@
+/*
+ * 运动学外推 (Dead Reckoning)
+ * ------------------------------------------------
+ * 结构: SoA 航迹表，每个字段一条连续数组，批量外推是纯 float 乘加循环。
+ * 滤波: 每条航迹一个 alpha-beta 滤波器，定位到达时 (约 1Hz) 做一次修正。
+ * 坐标: 以第一个定位点为原点的等距圆柱投影，几十公里范围内误差可忽略。
+ */
+
+#include "Kinematics.h"
+#include "BuildConfig.h"
+
+// 无屏版本不做外推，整张航迹表 (约 28KB .bss) 都不编译进去
+#if SCANNER_UI
+
+#include <math.h>
+#include <string.h>
+
+#define M_PER_DEG 111320.0   // 每度纬度对应的米数
+#define KIN_DEG2RAD 0.017453292519943295f
+
+// 滤波器系数
+#define KIN_ALPHA 0.5f  // 位置残差修正比例
+#define KIN_BETA  0.6f  // 向上报速度靠拢的比例
+#define KIN_GAMMA 0.1f  // 由位置残差反推速度的比例
+
+// === SoA 航迹表 ===
+static struct {
+    // 最近一次滤波后的状态 (本地平面, 米)
+    float posN[KIN_MAX_TRACKS];
+    float posE[KIN_MAX_TRACKS];
+    float posU[KIN_MAX_TRACKS];
+    float vn[KIN_MAX_TRACKS];
+    float ve[KIN_MAX_TRACKS];
+    float vu[KIN_MAX_TRACKS];
+    uint32_t tFix[KIN_MAX_TRACKS];
+
+    // 每帧外推结果
+    float predN[KIN_MAX_TRACKS];
+    float predE[KIN_MAX_TRACKS];
+    float predU[KIN_MAX_TRACKS];
+
+    // 返航点 (飞手位置) 与预计到达时间
+    float homeN[KIN_MAX_TRACKS];
+    float homeE[KIN_MAX_TRACKS];
+    float homeEta[KIN_MAX_TRACKS];
+
+    uint8_t used[KIN_MAX_TRACKS];
+    uint8_t hasFix[KIN_MAX_TRACKS];
+    uint8_t hasHome[KIN_MAX_TRACKS];
+    int hiwater; // 批量循环只跑到最高的已用槽位
+} kin;
+
+// 本地平面原点
+static bool originSet = false;
+static double originLat = 0, originLon = 0;
+static double mPerDegLon = M_PER_DEG;
+
+// === 辅助工具 ===
+static void toLocal(double lat, double lon, float *n, float *e) {
+    if (!originSet) {
+        originLat = lat; originLon = lon;
+        mPerDegLon = M_PER_DEG * cos(lat * (M_PI / 180.0));
+        originSet = true;
+    }
+    *n = (float)((lat - originLat) * M_PER_DEG);
+    *e = (float)((lon - originLon) * mPerDegLon);
+}
+
+static bool validSlot(int slot) {
+    return slot >= 0 && slot < KIN_MAX_TRACKS && kin.used[slot];
+}
+
+// 以速度 (vn, ve) 从 rel (= 位置 - 圆心) 出发，进入半径 r 的圆所需时间
+// 已在圆内返回 0，不会进入返回 -1
+static inline float timeToCircle(float relN, float relE, float vn, float ve, float r) {
+    float a = vn * vn + ve * ve;
+    float b = 2.0f * (relN * vn + relE * ve);
+    float c = relN * relN + relE * relE - r * r;
+    float disc = b * b - 4.0f * a * c;
+    float t = (-b - sqrtf(fmaxf(disc, 0.0f))) / (2.0f * a + 1e-6f);
+    float eta = (disc >= 0.0f && b < 0.0f && a > 1e-4f) ? t : -1.0f;
+    return (c <= 0.0f) ? 0.0f : eta;
+}
+
+// === 槽位管理 ===
+int kinAlloc() {
+    for (int i = 0; i < KIN_MAX_TRACKS; i++) {
+        if (kin.used[i]) continue;
+        kin.used[i] = 1; kin.hasFix[i] = 0; kin.hasHome[i] = 0;
+        kin.posN[i] = kin.posE[i] = kin.posU[i] = 0;
+        kin.vn[i] = kin.ve[i] = kin.vu[i] = 0;
+        kin.predN[i] = kin.predE[i] = kin.predU[i] = 0;
+        kin.homeEta[i] = -1.0f;
+        kin.tFix[i] = 0;
+        if (i + 1 > kin.hiwater) kin.hiwater = i + 1;
+        return i;
+    }
+    return -1;
+}
+
+void kinRelease(int slot) {
+    if (!validSlot(slot)) return;
+    kin.used[slot] = 0; kin.hasFix[slot] = 0; kin.hasHome[slot] = 0;
+    // 清零速度，空槽位在批量循环里就是静止点，不需要分支
+    kin.vn[slot] = kin.ve[slot] = kin.vu[slot] = 0;
+    while (kin.hiwater > 0 && !kin.used[kin.hiwater - 1]) kin.hiwater--;
+    // 全部航迹都消失后，下一个定位重新选原点
+    if (kin.hiwater == 0) originSet = false;
+}
+
+// === 单条航迹修正 (约 1Hz，标量) ===
+void kinUpdateFix(int slot, double lat, double lon, float alt,
+                  float speedH, float speedV, float dir, uint32_t now) {
+    if (!validSlot(slot)) return;
+
+    float mN, mE;
+    toLocal(lat, lon, &mN, &mE);
+    float mU = (alt > -1000.0f) ? alt : kin.posU[slot];
+
+    // 上报速度换算到北/东分量 (无效值按静止处理)
+    float sH = (speedH < 254.0f && dir <= 360.0f) ? speedH : 0.0f;
+    float sV = (speedV < 62.0f && speedV > -62.0f) ? speedV : 0.0f;
+    float rN = sH * cosf(dir * KIN_DEG2RAD);
+    float rE = sH * sinf(dir * KIN_DEG2RAD);
+
+    float dt = (now - kin.tFix[slot]) * 0.001f;
+    float pN = kin.posN[slot] + kin.vn[slot] * dt;
+    float pE = kin.posE[slot] + kin.ve[slot] * dt;
+    float pU = kin.posU[slot] + kin.vu[slot] * dt;
+    float resN = mN - pN, resE = mE - pE, resU = mU - pU;
+
+    bool reset = !kin.hasFix[slot] || dt > KIN_RESET_S || dt <= 0.0f ||
+                 (resN * resN + resE * resE) > KIN_RESET_JUMP_M * KIN_RESET_JUMP_M;
+    if (reset) {
+        kin.posN[slot] = mN; kin.posE[slot] = mE; kin.posU[slot] = mU;
+        kin.vn[slot] = rN; kin.ve[slot] = rE; kin.vu[slot] = sV;
+    } else {
+        kin.posN[slot] = pN + KIN_ALPHA * resN;
+        kin.posE[slot] = pE + KIN_ALPHA * resE;
+        kin.posU[slot] = pU + KIN_ALPHA * resU;
+        float g = KIN_GAMMA / dt;
+        kin.vn[slot] += KIN_BETA * (rN - kin.vn[slot]) + g * resN;
+        kin.ve[slot] += KIN_BETA * (rE - kin.ve[slot]) + g * resE;
+        kin.vu[slot] += KIN_BETA * (sV - kin.vu[slot]) + g * resU;
+    }
+    kin.predN[slot] = kin.posN[slot];
+    kin.predE[slot] = kin.posE[slot];
+    kin.predU[slot] = kin.posU[slot];
+    kin.tFix[slot] = now;
+    kin.hasFix[slot] = 1;
+}
+
+void kinSetHome(int slot, double lat, double lon) {
+    if (!validSlot(slot)) return;
+    toLocal(lat, lon, &kin.homeN[slot], &kin.homeE[slot]);
+    kin.hasHome[slot] = 1;
+}
+
+// === 批量外推 (每帧) ===
+// 单一循环，无函数调用、无数据相关分支，编译器可以展开/向量化
+void kinPredictAll(uint32_t now) {
+    const int n = kin.hiwater;
+    const float * __restrict posN = kin.posN;
+    const float * __restrict posE = kin.posE;
+    const float * __restrict posU = kin.posU;
+    const float * __restrict vn = kin.vn;
+    const float * __restrict ve = kin.ve;
+    const float * __restrict vu = kin.vu;
+    const uint32_t * __restrict tFix = kin.tFix;
+    float * __restrict predN = kin.predN;
+    float * __restrict predE = kin.predE;
+    float * __restrict predU = kin.predU;
+    float * __restrict homeEta = kin.homeEta;
+
+    for (int i = 0; i < n; i++) {
+        float dt = fminf((now - tFix[i]) * 0.001f, KIN_MAX_EXTRAP_S);
+        predN[i] = posN[i] + vn[i] * dt;
+        predE[i] = posE[i] + ve[i] * dt;
+        predU[i] = posU[i] + vu[i] * dt;
+        float eta = timeToCircle(predN[i] - kin.homeN[i], predE[i] - kin.homeE[i],
+                                 vn[i], ve[i], KIN_HOME_RADIUS_M);
+        homeEta[i] = (kin.hasHome[i] && kin.hasFix[i]) ? eta : -1.0f;
+    }
+}
+
+bool kinGetPredicted(int slot, double *lat, double *lon, float *alt) {
+    if (!validSlot(slot) || !kin.hasFix[slot]) return false;
+    *lat = originLat + kin.predN[slot] / M_PER_DEG;
+    *lon = originLon + kin.predE[slot] / mPerDegLon;
+    *alt = kin.predU[slot];
+    return true;
+}
+
+bool kinGetVelocity(int slot, float *speedH, float *dir, float *speedV) {
+    if (!validSlot(slot) || !kin.hasFix[slot]) return false;
+    float vn = kin.vn[slot], ve = kin.ve[slot];
+    *speedH = sqrtf(vn * vn + ve * ve);
+    float d = atan2f(ve, vn) / KIN_DEG2RAD;
+    *dir = (d < 0.0f) ? d + 360.0f : d;
+    *speedV = kin.vu[slot];
+    return true;
+}
+
+float kinHomeEta(int slot) {
+    if (!validSlot(slot)) return -1.0f;
+    return kin.homeEta[slot];
+}
+
+void kinFenceEta(double lat, double lon, float radius, float *out) {
+    // 原点只能由真实定位确定，不能被禁飞区圆心占用
+    int n = originSet ? kin.hiwater : 0;
+    float cN = 0, cE = 0;
+    if (originSet) toLocal(lat, lon, &cN, &cE);
+    for (int i = 0; i < n; i++) {
+        float eta = timeToCircle(kin.predN[i] - cN, kin.predE[i] - cE,
+                                 kin.vn[i], kin.ve[i], radius);
+        out[i] = kin.hasFix[i] ? eta : -1.0f;
+    }
+    for (int i = n; i < KIN_MAX_TRACKS; i++) out[i] = -1.0f;
+}
+
+#endif // SCANNER_UI
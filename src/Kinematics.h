@@ -0,0 +1,53 @@
+#ifndef KINEMATICS_H
+#define KINEMATICS_H
+
+#include <stdint.h>
+
+// === 运动学航迹表 (SoA) ===
+// Location 消息约 1Hz，这里按帧外推所有无人机的位置。
+// 所有坐标统一换算到以第一个定位点为原点的本地平面 (北/东/天, 米, float)，
+// 批量外推只做 float 乘加，ESP32-S3 的单精度 FPU 可以直接跑满。
+// 注意: 所有接口都不加锁，调用方必须持有 listMutex。
+
+#define KIN_MAX_TRACKS     512    // 同时跟踪的航迹上限 (约 28KB 内部 RAM)，超出的无人机不做外推
+#define KIN_MAX_EXTRAP_S   10.0f  // 外推最长时间 (s)，超过后位置冻结
+#define KIN_RESET_S        5.0f   // 两次定位间隔超过此值则重置滤波器
+#define KIN_RESET_JUMP_M   200.0f // 新定位偏离预测超过此值则重置滤波器
+#define KIN_HOME_RADIUS_M  10.0f  // 到达飞手点的判定半径 (m)
+
+// 可选的圆形禁飞区，在 build_flags 中同时定义以下三项即启用，例如:
+//   -DKIN_FENCE_LAT=31.2304 -DKIN_FENCE_LON=121.4737 -DKIN_FENCE_RADIUS_M=500
+#if defined(KIN_FENCE_LAT) && defined(KIN_FENCE_LON) && defined(KIN_FENCE_RADIUS_M)
+#define KIN_HAS_FENCE 1
+#else
+#define KIN_HAS_FENCE 0
+#endif
+
+// 分配/释放航迹槽位，满了返回 -1
+int kinAlloc();
+void kinRelease(int slot);
+
+// 喂入一次 Location 定位 (原始浮点值，无效值按 ODID 约定: speed 255, dir 361)
+void kinUpdateFix(int slot, double lat, double lon, float alt,
+                  float speedH, float speedV, float dir, uint32_t now);
+
+// 设置 "返航点" (System 消息里的飞手位置)
+void kinSetHome(int slot, double lat, double lon);
+
+// 每帧调用一次: 批量外推所有航迹，并刷新到返航点的预计时间
+void kinPredictAll(uint32_t now);
+
+// 读取最近一次 kinPredictAll 的结果，无定位时返回 false
+bool kinGetPredicted(int slot, double *lat, double *lon, float *alt);
+
+// 读取滤波后的速度: 水平速度 (m/s)、航向 (0-360)、垂直速度 (m/s)，无定位时返回 false
+bool kinGetVelocity(int slot, float *speedH, float *dir, float *speedV);
+
+// 到返航点的预计时间 (s)，已到达为 0，不会到达/无数据为 -1
+float kinHomeEta(int slot);
+
+// 批量计算所有航迹进入圆形禁飞区的预计时间，out 长度为 KIN_MAX_TRACKS
+// 还没有任何定位 (本地平面原点未定) 时全部输出 -1
+void kinFenceEta(double lat, double lon, float radius, float *out);
+
+#endif
@@ -0,0 +1,78 @@
+#include "ReportStream.h"
+
+#define STREAM_QUEUE_LEN 64
+
+// 队列中的报文快照 (定长，不含 String，可以按值拷贝进 FreeRTOS 队列)
+struct StreamReport {
+    uint32_t ms;
+    char mac[18];
+    char sn[21];
+    uint8_t phy;
+    uint8_t typeMask;
+    int8_t rssi;
+    double lat, lon;
+    double op_lat, op_lon;
+    int16_t alt, height;
+    int16_t speed_h, speed_v, dir;
+};
+
+static QueueHandle_t reportQueue = nullptr;
+
+void streamInit() {
+    reportQueue = xQueueCreate(STREAM_QUEUE_LEN, sizeof(StreamReport));
+}
+
+// sn 来自空口数据，写进逗号分隔的行之前把分隔符、换行和不可打印字符替换掉
+static void copyFieldSafe(char *dst, const String &src, size_t size) {
+    size_t n = 0;
+    for (; n + 1 < size && n < src.length(); n++) {
+        char c = src[n];
+        dst[n] = (c < 0x20 || c > 0x7E || c == ',') ? '_' : c;
+    }
+    dst[n] = 0;
+}
+
+bool streamPush(const DroneInfo &d, uint8_t typeMask) {
+    if (!reportQueue) return false;
+    StreamReport r = {};
+    r.ms = d.lastSeen;
+    strlcpy(r.mac, d.mac.c_str(), sizeof(r.mac));
+    copyFieldSafe(r.sn, d.sn, sizeof(r.sn));
+    r.phy = (d.proto == "BLE 5") ? 5 : 4;
+    r.typeMask = typeMask;
+    r.rssi = (int8_t)d.rssi;
+    // 只拷贝本条广播里出现过的字段组，其余保持为 0 (输出为空字段)
+    if (typeMask & STREAM_HAS_LOCATION) {
+        r.lat = d.lat; r.lon = d.lon;
+        r.alt = d.alt; r.height = d.height;
+        r.speed_h = d.speed_h; r.speed_v = d.speed_v; r.dir = d.dir;
+    }
+    if (typeMask & STREAM_HAS_SYSTEM) { r.op_lat = d.op_lat; r.op_lon = d.op_lon; }
+    return xQueueSend(reportQueue, &r, 0) == pdTRUE;
+}
+
+void streamFlush() {
+    if (!reportQueue) return;
+    StreamReport r;
+    char line[192];
+    while (xQueueReceive(reportQueue, &r, 0) == pdTRUE) {
+        int n = snprintf(line, sizeof(line), "$ODID,%lu,%s,%u,%d,%s,",
+                         (unsigned long)r.ms, r.mac, r.phy, r.rssi, r.sn);
+        if (r.typeMask & STREAM_HAS_LOCATION)
+            n += snprintf(line + n, sizeof(line) - n, "%.7f,%.7f,%d,%d,%d,%d,%d,",
+                          r.lat, r.lon, r.alt, r.height, r.speed_h, r.speed_v, r.dir);
+        else
+            n += snprintf(line + n, sizeof(line) - n, ",,,,,,,");
+        if (r.typeMask & STREAM_HAS_SYSTEM)
+            n += snprintf(line + n, sizeof(line) - n, "%.7f,%.7f,", r.op_lat, r.op_lon);
+        else
+            n += snprintf(line + n, sizeof(line) - n, ",,");
+        snprintf(line + n, sizeof(line) - n, "%02X\n", r.typeMask);
+        Serial.print(line);
+    }
+}
+
+void streamStat(uint32_t now, uint32_t reports, uint32_t lockMiss, uint32_t queueFull, int drones) {
+    Serial.printf("#STAT,%lu,%lu,%lu,%lu,%d\n", (unsigned long)now, (unsigned long)reports,
+                  (unsigned long)lockMiss, (unsigned long)queueFull, drones);
+}
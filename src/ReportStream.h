@@ -0,0 +1,34 @@
+#ifndef REPORT_STREAM_H
+#define REPORT_STREAM_H
+
+#include <stdint.h>
+#include "DroneStore.h"
+
+// === 串口流输出 (无屏版本) ===
+// 扫描回调只负责把快照压入队列，主循环负责格式化和输出，回调里不碰串口。
+//
+// 行格式 (逗号分隔，一行一条报文):
+//   $ODID,<ms>,<mac>,<phy 4|5>,<rssi>,<sn>,<lat>,<lon>,<alt>,<height>,
+//         <speed_h>,<speed_v>,<dir>,<op_lat>,<op_lon>,<types 位掩码 hex>
+//   位置字段 (lat..dir) 只在本条广播含 Location 时输出，飞手位置只在含 System 时输出，
+//   否则对应字段为空。
+//   #STAT,<ms>,<reports/s>,<lock_miss/s>,<queue_full/s>,<drones>
+//   lock_miss: 回调拿不到 listMutex 丢弃的报文 (两种版本都有)
+//   queue_full: 输出队列满丢弃的报文 (仅无屏版本)
+// 以 '#' 开头的行是统计信息，不是报文。
+
+#define STREAM_HAS_LOCATION (1 << 1)
+#define STREAM_HAS_SYSTEM   (1 << 4)
+
+void streamInit();
+
+// 扫描回调中调用 (需持有 listMutex)，队列满时返回 false
+bool streamPush(const DroneInfo &d, uint8_t typeMask);
+
+// 主循环中调用: 输出队列中所有报文
+void streamFlush();
+
+// 输出一行统计信息
+void streamStat(uint32_t now, uint32_t reports, uint32_t lockMiss, uint32_t queueFull, int drones);
+
+#endif
@@ -7,6 +7,9 @@
 
 #include "ScannerBLE.h"
 #include "DroneStore.h"
+#include "Kinematics.h"
+#include "BuildConfig.h"
+#include "ReportStream.h"
 #include <BLEDevice.h>
 #include <BLEUtils.h>
 #include <BLEScan.h>
@@ -17,6 +20,11 @@ extern "C" {
     #include "opendroneid.h"
 }
 
+// === 统计计数 (reports/sec 与丢包率基准) ===
+static volatile uint32_t statReports = 0; // 收到的 ODID 广播报文
+static volatile uint32_t statLockMiss = 0;  // 拿不到 listMutex 而丢弃的报文
+static volatile uint32_t statQueueFull = 0; // 输出队列满而丢弃的报文 (仅无屏版本)
+
 // === 辅助工具 ===
 static void safeStrCopy(String &target, char* src, int len) {
     char temp[len + 1]; memset(temp, 0, len + 1);
@@ -95,6 +103,10 @@ static int parse_block(DroneInfo &d, uint8_t *block) {
                 d.speed_v = (int)data.SpeedVertical;
                 d.dir = (int)data.Direction;
                 d.status = getStatusStr(data.Status);
+#if SCANNER_UI
+                kinUpdateFix(d.kinSlot, data.Latitude, data.Longitude, data.AltitudeBaro,
+                             data.SpeedHorizontal, data.SpeedVertical, data.Direction, millis());
+#endif
                 return 1;
             }
             break;
@@ -128,6 +140,9 @@ static int parse_block(DroneInfo &d, uint8_t *block) {
                 d.op_lat = data.OperatorLatitude;
                 d.op_lon = data.OperatorLongitude;
                 d.op_alt = (int)data.OperatorAltitudeGeo;
+#if SCANNER_UI
+                kinSetHome(d.kinSlot, data.OperatorLatitude, data.OperatorLongitude);
+#endif
                 return 4;
             }
             break;
@@ -159,6 +174,7 @@ static void ble_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param
             if (raw[i] == 0xFA && raw[i+1] == 0xFF) { anchor = i + 2; break; }
         }
         if (anchor == -1) return;
+        statReports++;
 
         uint8_t *payload = &raw[anchor];
         int payloadLen = len - anchor;
@@ -175,8 +191,13 @@ static void ble_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param
                 if (d.mac == macStr && d.proto == proto) { target = &d; break; }
             }
             if (!target) {
-                DroneInfo newD; newD.mac = macStr; newD.proto = proto;
-                newD.lat=0; newD.lon=0; newD.msgCount=0;
+                DroneInfo newD{}; newD.mac = macStr; newD.proto = proto;
+                // 外推只服务于屏幕显示，无屏版本不链接 Kinematics
+#if SCANNER_UI
+                newD.kinSlot = kinAlloc();
+#else
+                newD.kinSlot = -1;
+#endif
                 droneList.push_back(newD);
                 target = &droneList.back();
             }
@@ -185,6 +206,7 @@ static void ble_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param
             target->lastSeen = millis();
             
             String types = "";
+            uint8_t typeMask = 0;
             int offset = 0;
             // 循环解析直到末尾
             while (offset + 25 <= payloadLen) {
@@ -192,13 +214,19 @@ static void ble_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param
                 if (res != -1) {
                     target->msgCount++;
                     types += String(res) + ",";
+                    typeMask |= (1 << res);
                     offset += 25; // 成功解析，跳跃 25
                 } else {
                     offset++; // 解析失败，滑窗 1
                 }
             }
             if(types.length() > 0) target->debugTypes = types;
+            if (BuildConfig::streamReports && typeMask != 0) {
+                if (!streamPush(*target, typeMask)) statQueueFull++;
+            }
             xSemaphoreGive(listMutex);
+        } else {
+            statLockMiss++;
         }
     }
 }
@@ -214,8 +242,8 @@ void startBLE() {
         .filter_policy = BLE_SCAN_FILTER_ALLOW_ALL,
         .scan_duplicate = BLE_SCAN_DUPLICATE_DISABLE,
         .cfg_mask = ESP_BLE_GAP_EXT_SCAN_CFG_UNCODE_MASK | ESP_BLE_GAP_EXT_SCAN_CFG_CODE_MASK,
-        .uncoded_cfg = {BLE_SCAN_TYPE_ACTIVE, 40, 30},
-        .coded_cfg = {BLE_SCAN_TYPE_ACTIVE, 40, 30},
+        .uncoded_cfg = {(esp_ble_scan_type_t)BuildConfig::scanType, BuildConfig::scanInterval, BuildConfig::scanWindow},
+        .coded_cfg = {(esp_ble_scan_type_t)BuildConfig::scanType, BuildConfig::scanInterval, BuildConfig::scanWindow},
     };
     esp_ble_gap_set_ext_scan_params(&params);
     esp_ble_gap_start_ext_scan(0, 0);
@@ -223,4 +251,10 @@ void startBLE() {
 
 void stopBLE() {
     esp_ble_gap_stop_ext_scan();
+}
+
+void getScanStats(uint32_t *reports, uint32_t *lockMiss, uint32_t *queueFull) {
+    *reports = statReports;
+    *lockMiss = statLockMiss;
+    *queueFull = statQueueFull;
 }
\ No newline at end of file
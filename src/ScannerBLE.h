@@ -1,8 +1,13 @@
 #ifndef SCANNER_BLE_H
 #define SCANNER_BLE_H
 
+#include <stdint.h>
+
 void initBLE();   // 初始化蓝牙硬件
 void startBLE();  // 开始扫描 (开启射频)
 void stopBLE();   // 停止扫描 (释放射频给 WiFi)
 
+// 累计统计: 收到的 ODID 报文数 / 拿不到锁丢弃数 / 输出队列满丢弃数
+void getScanStats(uint32_t *reports, uint32_t *lockMiss, uint32_t *queueFull);
+
 #endif
\ No newline at end of file
@@ -8,15 +8,23 @@
 
 
 #include <Arduino.h>
+#include "BuildConfig.h"
+#if SCANNER_UI
 #include <Arduino_GFX_Library.h>
 #include <Wire.h>
+#endif
 #include "DroneStore.h"
 #include "ScannerBLE.h"
+#include "Kinematics.h"
+#include "ReportStream.h"
 
 // ================= 1. 全局变量 =================
 std::vector<DroneInfo> droneList;
 SemaphoreHandle_t listMutex;
 
+// 以下屏幕/触摸/绘图代码仅在 UI 版本中编译 (见 BuildConfig.h)
+#if SCANNER_UI
+
 // ================= 2. 硬件配置 =================
 #define PIN_POWER_ON 15
 #define LCD_CS 6
@@ -59,6 +67,11 @@ int dragBackDist = 0; bool isSwipingBack = false;
 int pressedIndex = -1; 
 
 int selectedIndex = -1;
+
+#if KIN_HAS_FENCE
+// 每帧批量计算的禁飞区预计进入时间 (按航迹槽位索引)
+float fenceEta[KIN_MAX_TRACKS];
+#endif
 int detailPage = 0;
 
 // GFX
@@ -225,8 +238,19 @@ void drawDetailScreen() {
     
     DroneInfo t;
     bool hasData = false;
+    double predLat = 0, predLon = 0; float predAlt = 0;
+    bool hasPred = false; float homeEta = -1, fenceEtaSel = -1;
+    float predSpeedH = 0, predDir = 0, predSpeedV = 0;
     if (xSemaphoreTake(listMutex, 50) == pdTRUE) {
-        if (selectedIndex >= 0 && selectedIndex < droneList.size()) { t = droneList[selectedIndex]; hasData = true; } 
+        if (selectedIndex >= 0 && selectedIndex < droneList.size()) { 
+            t = droneList[selectedIndex]; hasData = true; 
+            hasPred = kinGetPredicted(t.kinSlot, &predLat, &predLon, &predAlt);
+            kinGetVelocity(t.kinSlot, &predSpeedH, &predDir, &predSpeedV);
+            homeEta = kinHomeEta(t.kinSlot);
+#if KIN_HAS_FENCE
+            if (t.kinSlot >= 0) fenceEtaSel = fenceEta[t.kinSlot];
+#endif
+        } 
         else { currentState = STATE_LIST; }
         xSemaphoreGive(listMutex);
     }
@@ -242,6 +266,8 @@ void drawDetailScreen() {
     
     canvas->setTextColor(GREEN); canvas->setCursor(420, 10); canvas->printf("%d dBm", t.rssi);
     canvas->setTextSize(1); canvas->setTextColor(CYAN); canvas->setCursor(20, 38); canvas->printf("MAC: %s (%s)", t.mac.c_str(), t.proto.c_str());
+    // 航迹表已满时该无人机没有外推/ETA
+    if (t.kinSlot < 0) { canvas->setTextColor(RED); canvas->print("  (no track)"); }
 
     // --- Static Content Area ---
     int baseY = 70;
@@ -251,19 +277,37 @@ void drawDetailScreen() {
     if (detailPage == 0) { // === Page 1: Flight ===
         drawItemCompact(col1, baseY, "MODEL / TYPE", (t.uaType.length()>0 ? t.uaType : "N/A"), GREEN);
         drawItemCompact(col2, baseY, "STATUS", (t.status.length()>0 ? t.status : "N/A"), YELLOW);
-        drawItemCompact(col3, baseY, "HEADING", String(t.dir) + " deg");
+        // 有外推结果时航向/速度也显示滤波值，避免每秒跳变
+        if (hasPred) drawItemCompact(col3, baseY, "HEADING", String((int)predDir) + " deg", GREEN);
+        else drawItemCompact(col3, baseY, "HEADING", String(t.dir) + " deg");
         
         baseY += gap;
-        drawItemCompact(col1, baseY, "LATITUDE", (t.lat!=0 ? String(t.lat, 6) : "N/A"));
-        drawItemCompact(col2, baseY, "LONGITUDE", (t.lon!=0 ? String(t.lon, 6) : "N/A"));
+        // 有外推结果时显示预测位置，否则显示最近一次上报
+        if (hasPred) {
+            drawItemCompact(col1, baseY, "LATITUDE (Pred)", String(predLat, 6), GREEN);
+            drawItemCompact(col2, baseY, "LONGITUDE (Pred)", String(predLon, 6), GREEN);
+        } else {
+            drawItemCompact(col1, baseY, "LATITUDE", (t.lat!=0 ? String(t.lat, 6) : "N/A"));
+            drawItemCompact(col2, baseY, "LONGITUDE", (t.lon!=0 ? String(t.lon, 6) : "N/A"));
+        }
         
         baseY += gap;
-        drawItemCompact(col1, baseY, "ALTITUDE (Baro)", (t.lat!=0 ? String(t.alt)+" m" : "N/A"), CYAN);
+        if (hasPred) drawItemCompact(col1, baseY, "ALTITUDE (Pred)", String((int)predAlt)+" m", GREEN);
+        else drawItemCompact(col1, baseY, "ALTITUDE (Baro)", (t.lat!=0 ? String(t.alt)+" m" : "N/A"), CYAN);
         drawItemCompact(col2, baseY, "HEIGHT (Rel)", (t.lat!=0 ? String(t.height)+" m" : "N/A"), CYAN);
+#if KIN_HAS_FENCE
+        drawItemCompact(col3, baseY, "FENCE ETA", (fenceEtaSel >= 0 ? String((int)fenceEtaSel)+" s" : "N/A"), RED);
+#endif
         
         baseY += gap;
-        drawItemCompact(col1, baseY, "SPEED H", String(t.speed_h)+" m/s");
-        drawItemCompact(col2, baseY, "SPEED V", String(t.speed_v)+" m/s");
+        if (hasPred) {
+            drawItemCompact(col1, baseY, "SPEED H", String(predSpeedH, 1)+" m/s", GREEN);
+            drawItemCompact(col2, baseY, "SPEED V", String(predSpeedV, 1)+" m/s", GREEN);
+        } else {
+            drawItemCompact(col1, baseY, "SPEED H", String(t.speed_h)+" m/s");
+            drawItemCompact(col2, baseY, "SPEED V", String(t.speed_v)+" m/s");
+        }
+        drawItemCompact(col3, baseY, "HOME ETA", (homeEta >= 0 ? String((int)homeEta)+" s" : "N/A"), YELLOW);
 
     } else if (detailPage == 1) { // === Page 2: System ===
         drawItemCompact(col1, baseY, "OPERATOR ID", (t.operatorId.length()>0 ? t.operatorId : "None"));
@@ -304,24 +348,58 @@ void drawDetailScreen() {
     canvas->setCursor(220, 225); canvas->printf("PAGE %d/3 (Tap to flip)", detailPage + 1);
 }
 
+#endif // SCANNER_UI
+
 // ================= 6. Setup & Loop =================
 void setup() {
     Serial.begin(115200);
+#if SCANNER_UI
     pinMode(PIN_POWER_ON, OUTPUT); digitalWrite(PIN_POWER_ON, HIGH); delay(100);
     if (!canvas->begin()) { Serial.println("GFX Fail"); while(1); }
     canvas->setRotation(1);
     Wire.begin(TOUCH_SDA, TOUCH_SCL);
+#endif
     listMutex = xSemaphoreCreateMutex();
+    if (BuildConfig::streamReports) streamInit();
     initBLE();
     startBLE();
 }
 
+// 每秒输出一次扫描统计 (报文数/丢包数为该周期内的增量)
+static void reportStats() {
+    static unsigned long lastStat = 0;
+    static uint32_t lastReports = 0, lastLockMiss = 0, lastQueueFull = 0;
+    if (millis() - lastStat < BuildConfig::statPeriodMs) return;
+    lastStat = millis();
+    uint32_t reports, lockMiss, queueFull;
+    getScanStats(&reports, &lockMiss, &queueFull);
+    int drones = -1;
+    if (xSemaphoreTake(listMutex, 10) == pdTRUE) {
+        drones = droneList.size();
+        xSemaphoreGive(listMutex);
+    }
+    streamStat(lastStat, reports - lastReports, lockMiss - lastLockMiss, queueFull - lastQueueFull, drones);
+    lastReports = reports; lastLockMiss = lockMiss; lastQueueFull = queueFull;
+}
+
 void loop() {
+#if SCANNER_UI
+    // 每帧批量外推所有航迹
+    if (xSemaphoreTake(listMutex, 10) == pdTRUE) {
+        kinPredictAll(millis());
+#if KIN_HAS_FENCE
+        kinFenceEta(KIN_FENCE_LAT, KIN_FENCE_LON, KIN_FENCE_RADIUS_M, fenceEta);
+#endif
+        xSemaphoreGive(listMutex);
+    }
     updatePhysics();
     handleTouch();
     if (currentState == STATE_LIST) drawListScreen(); else drawDetailScreen();
     drawDrawerAnimation();
     canvas->flush();
+#endif
+    if (BuildConfig::streamReports) streamFlush();
+    reportStats();
     
     // [Fix] 20秒超时移除
     static unsigned long lastClean = 0;
@@ -330,11 +408,16 @@ void loop() {
         if (xSemaphoreTake(listMutex, 10) == pdTRUE) {
             for (auto it = droneList.begin(); it != droneList.end(); ) {
                 // 修改此处为 20000 (20秒)
-                if (millis() - it->lastSeen > 20000) it = droneList.erase(it);
+                if (millis() - it->lastSeen > 20000) {
+#if SCANNER_UI
+                    kinRelease(it->kinSlot);
+#endif
+                    it = droneList.erase(it);
+                }
                 else ++it;
             }
             xSemaphoreGive(listMutex);
         }
     }
-    delay(20);
+    delay(BuildConfig::loopDelayMs);
 }
\ No newline at end of file
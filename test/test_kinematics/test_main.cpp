@@ -0,0 +1,112 @@
+/*
+ * Kinematics 主机端单元测试 (pio test -e native)
+ * 覆盖: 外推、外推上限、alpha-beta 修正、跳变重置、返航/禁飞区 ETA
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "Kinematics.h"
+
+#define LAT0 31.2304
+#define LON0 121.4737
+#define M_PER_DEG 111320.0
+
+static int slot = -1;
+
+// 北/东偏移 (米) 换算成经纬度
+static double latN(double n) { return LAT0 + n / M_PER_DEG; }
+static double lonE(double e) { return LON0 + e / (M_PER_DEG * cos(LAT0 * M_PI / 180.0)); }
+
+void setUp() { slot = kinAlloc(); }
+void tearDown() { kinRelease(slot); }
+
+static void test_constant_velocity_prediction() {
+    // 向东 10 m/s，2 秒后应在东侧 20 m
+    kinUpdateFix(slot, LAT0, LON0, 50, 10, 0, 90, 1000);
+    kinPredictAll(3000);
+    double lat, lon; float alt;
+    TEST_ASSERT_TRUE(kinGetPredicted(slot, &lat, &lon, &alt));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-6, LAT0, lat);
+    TEST_ASSERT_DOUBLE_WITHIN(0.1 / M_PER_DEG, lonE(20), lon);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 50.0f, alt);
+}
+
+static void test_extrapolation_is_capped() {
+    kinUpdateFix(slot, LAT0, LON0, 50, 10, 0, 0, 1000);
+    kinPredictAll(1000 + 60000);
+    double lat, lon; float alt;
+    kinGetPredicted(slot, &lat, &lon, &alt);
+    TEST_ASSERT_DOUBLE_WITHIN(0.1 / M_PER_DEG, latN(10.0f * KIN_MAX_EXTRAP_S), lat);
+}
+
+static void test_alpha_beta_update() {
+    // 静止上报，但 1 秒后位置北移 10 m: 位置修正一半 (alpha=0.5)，
+    // 速度 = beta*(0-0) + gamma*10/1 = 1 m/s 向北
+    kinUpdateFix(slot, LAT0, LON0, 50, 0, 0, 0, 1000);
+    kinUpdateFix(slot, latN(10), LON0, 50, 0, 0, 0, 2000);
+    kinPredictAll(2000);
+    double lat, lon; float alt;
+    kinGetPredicted(slot, &lat, &lon, &alt);
+    TEST_ASSERT_DOUBLE_WITHIN(0.05 / M_PER_DEG, latN(5), lat);
+
+    float speedH, dir, speedV;
+    TEST_ASSERT_TRUE(kinGetVelocity(slot, &speedH, &dir, &speedV));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, speedH);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 0.0f, dir);
+}
+
+static void test_jump_resets_filter() {
+    kinUpdateFix(slot, LAT0, LON0, 50, 0, 0, 0, 1000);
+    kinUpdateFix(slot, latN(1000), LON0, 50, 5, 0, 180, 2000);
+    kinPredictAll(2000);
+    double lat, lon; float alt;
+    kinGetPredicted(slot, &lat, &lon, &alt);
+    TEST_ASSERT_DOUBLE_WITHIN(0.05 / M_PER_DEG, latN(1000), lat);
+
+    float speedH, dir, speedV;
+    kinGetVelocity(slot, &speedH, &dir, &speedV);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 5.0f, speedH);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 180.0f, dir);
+}
+
+static void test_home_eta() {
+    // 飞手在北侧 100 m，向北 10 m/s: (100 - 10 m 半径) / 10 = 9 s
+    kinUpdateFix(slot, LAT0, LON0, 50, 10, 0, 0, 1000);
+    kinSetHome(slot, latN(100), LON0);
+    kinPredictAll(1000);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 9.0f, kinHomeEta(slot));
+
+    // 背离飞手: 不会到达
+    kinUpdateFix(slot, LAT0, LON0, 50, 10, 0, 180, 7000);
+    kinPredictAll(7000);
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, kinHomeEta(slot));
+
+    // 已在半径内
+    kinSetHome(slot, latN(5), LON0);
+    kinPredictAll(7000);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, kinHomeEta(slot));
+}
+
+static void test_fence_eta() {
+    static float out[KIN_MAX_TRACKS];
+    // 还没有定位: 全部 -1
+    kinFenceEta(latN(500), LON0, 100, out);
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, out[slot]);
+
+    // 向北 20 m/s，禁飞区圆心北侧 500 m、半径 100 m: 400 / 20 = 20 s
+    kinUpdateFix(slot, LAT0, LON0, 50, 20, 0, 0, 1000);
+    kinPredictAll(1000);
+    kinFenceEta(latN(500), LON0, 100, out);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 20.0f, out[slot]);
+}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_constant_velocity_prediction);
+    RUN_TEST(test_extrapolation_is_capped);
+    RUN_TEST(test_alpha_beta_update);
+    RUN_TEST(test_jump_resets_filter);
+    RUN_TEST(test_home_eta);
+    RUN_TEST(test_fence_eta);
+    return UNITY_END();
+}
@@ -0,0 +1,76 @@
+#include "Report.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// === 辅助工具 ===
+// 取下一个逗号分隔字段，返回字段长度，*p 前进到下一个字段开头
+static size_t nextField(const char **p, const char *end, const char **field) {
+    const char *s = *p;
+    const char *c = (const char *)memchr(s, ',', end - s);
+    if (!c) c = end;
+    *field = s;
+    *p = (c < end) ? c + 1 : end;
+    return c - s;
+}
+
+static long toLong(const char *s, size_t n) {
+    char tmp[24];
+    if (n >= sizeof(tmp)) n = sizeof(tmp) - 1;
+    memcpy(tmp, s, n); tmp[n] = 0;
+    return strtol(tmp, nullptr, 10);
+}
+
+static double toDouble(const char *s, size_t n) {
+    char tmp[32];
+    if (n >= sizeof(tmp)) n = sizeof(tmp) - 1;
+    memcpy(tmp, s, n); tmp[n] = 0;
+    return strtod(tmp, nullptr);
+}
+
+static void copyField(char *dst, size_t size, const char *s, size_t n) {
+    if (n >= size) n = size - 1;
+    memcpy(dst, s, n); dst[n] = 0;
+}
+
+bool parseReport(const char *line, size_t len, Report *out) {
+    if (len > 0 && line[len - 1] == '\r') len--;
+    if (len < 6 || memcmp(line, "$ODID,", 6) != 0) return false;
+
+    const char *p = line + 6, *end = line + len;
+    const char *f[15]; size_t n[15];
+    for (int i = 0; i < 15; i++) {
+        if (i > 0 && p >= end) return false;
+        n[i] = nextField(&p, end, &f[i]);
+    }
+    // f[0] 是扫描器自身的 millis()，各扫描器之间不可比，聚合端不使用
+    if (n[1] != 17) return false;
+    copyField(out->mac, sizeof(out->mac), f[1], n[1]);
+    out->phy = (uint8_t)toLong(f[2], n[2]);
+    out->rssi = (int8_t)toLong(f[3], n[3]);
+    copyField(out->sn, sizeof(out->sn), f[4], n[4]);
+    out->lat = toDouble(f[5], n[5]);
+    out->lon = toDouble(f[6], n[6]);
+    out->alt = (int16_t)toLong(f[7], n[7]);
+    out->height = (int16_t)toLong(f[8], n[8]);
+    out->speed_h = (int16_t)toLong(f[9], n[9]);
+    out->speed_v = (int16_t)toLong(f[10], n[10]);
+    out->dir = (int16_t)toLong(f[11], n[11]);
+    out->op_lat = toDouble(f[12], n[12]);
+    out->op_lon = toDouble(f[13], n[13]);
+    char hex[4]; copyField(hex, sizeof(hex), f[14], n[14]);
+    out->typeMask = (uint8_t)strtol(hex, nullptr, 16);
+    return true;
+}
+
+int formatReport(const Report &r, uint32_t ms, char *buf, size_t size) {
+    return snprintf(buf, size, "$ODID,%u,%s,%u,%d,%s,%.7f,%.7f,%d,%d,%d,%d,%d,%.7f,%.7f,%02X\n",
+                    ms, r.mac, r.phy, r.rssi, r.sn, r.lat, r.lon,
+                    r.alt, r.height, r.speed_h, r.speed_v, r.dir, r.op_lat, r.op_lon, r.typeMask);
+}
+
+uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
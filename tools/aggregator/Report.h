@@ -0,0 +1,32 @@
+#ifndef AGG_REPORT_H
+#define AGG_REPORT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// === 单条扫描报文 ===
+// 对应固件无屏版本输出的 "$ODID,..." 行 (格式见 src/ReportStream.h)
+struct Report {
+    uint16_t scanner;   // 来源扫描器编号 (聚合端分配)
+    uint8_t phy;        // 4 = BLE 4 (1M)，5 = BLE 5 (Coded)
+    uint8_t typeMask;   // 本条广播里解析到的消息类型位掩码
+    int8_t rssi;
+    char mac[18];
+    char sn[21];
+    double lat, lon;
+    double op_lat, op_lon;
+    int16_t alt, height;
+    int16_t speed_h, speed_v, dir;
+    uint64_t rxNs;      // 聚合端收到该行的时间 (steady clock)
+};
+
+// 解析一行 (不含换行)，非报文行 (如 "#STAT") 或格式错误返回 false
+bool parseReport(const char *line, size_t len, Report *out);
+
+// 把报文格式化回 "$ODID,..." 行 (负载生成器使用)，返回写入长度
+int formatReport(const Report &r, uint32_t ms, char *buf, size_t size);
+
+// 单调时钟 (ns)
+uint64_t nowNs();
+
+#endif
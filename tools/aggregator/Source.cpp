@@ -0,0 +1,181 @@
+#include "Source.h"
+#include <arpa/inet.h>
+#include <chrono>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+
+// === 扫描器登记 ===
+uint16_t ScannerRegistry::acquire(const std::string &name) {
+    std::lock_guard<std::mutex> lk(mu);
+    for (size_t i = 0; i < names.size(); i++) {
+        if (names[i] == name && !online[i]) { online[i] = true; return (uint16_t)i; }
+    }
+    names.push_back(name);
+    online.push_back(true);
+    return (uint16_t)(names.size() - 1);
+}
+
+void ScannerRegistry::release(uint16_t id) {
+    std::lock_guard<std::mutex> lk(mu);
+    if (id < online.size()) online[id] = false;
+}
+
+std::string ScannerRegistry::name(uint16_t id) {
+    std::lock_guard<std::mutex> lk(mu);
+    return id < names.size() ? names[id] : "?";
+}
+
+size_t ScannerRegistry::size() {
+    std::lock_guard<std::mutex> lk(mu);
+    return names.size();
+}
+
+// === 读取循环 ===
+// 每次 read() 得到的所有完整行共用一个接收时间戳，读完一块立即 flush，
+// 低负载时不会因为攒批而增加延迟
+static void readLoop(int fd, uint16_t scanner, TrackTable &table, size_t batchSize) {
+    BatchRouter router(table, batchSize);
+    char buf[16384];
+    size_t used = 0;
+    Report r;
+    r.scanner = scanner;
+    for (;;) {
+        ssize_t n = read(fd, buf + used, sizeof(buf) - used);
+        if (n <= 0) break;
+        used += n;
+        r.rxNs = nowNs();
+
+        size_t start = 0;
+        for (;;) {
+            char *nl = (char *)memchr(buf + start, '\n', used - start);
+            if (!nl) break;
+            size_t len = nl - (buf + start);
+            if (parseReport(buf + start, len, &r)) router.add(r);
+            start += len + 1;
+        }
+        // 超长无换行的垃圾数据直接丢弃
+        if (start == 0 && used == sizeof(buf)) used = 0;
+        else { memmove(buf, buf + start, used - start); used -= start; }
+        router.flush();
+    }
+    router.flush();
+}
+
+static int openSerial(const char *dev) {
+    int fd = open(dev, O_RDONLY | O_NOCTTY);
+    if (fd < 0) return -1;
+    struct termios tio;
+    if (tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, B115200); // USB CDC 忽略波特率，真实串口与固件 monitor_speed 一致
+        tio.c_cc[VMIN] = 1; tio.c_cc[VTIME] = 0;
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    return fd;
+}
+
+static int connectTcp(const std::string &hostPort) {
+    size_t colon = hostPort.rfind(':');
+    if (colon == std::string::npos) return -1;
+    std::string host = hostPort.substr(0, colon), port = hostPort.substr(colon + 1);
+    struct addrinfo hints = {}, *res = nullptr;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0) return -1;
+    int fd = -1;
+    for (struct addrinfo *ai = res; ai; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+        close(fd); fd = -1;
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+static int listenTcp(int port) {
+    int fd = socket(AF_INET6, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    int on = 1, off = 0;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &off, sizeof(off));
+    struct sockaddr_in6 addr = {};
+    addr.sin6_family = AF_INET6;
+    addr.sin6_addr = in6addr_any;
+    addr.sin6_port = htons(port);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 64) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void runReader(int fd, uint16_t scanner, TrackTable &table, ScannerRegistry &reg,
+                      size_t batchSize, std::atomic<int> &active, bool closeFd) {
+    readLoop(fd, scanner, table, batchSize);
+    if (closeFd) close(fd);
+    reg.release(scanner);
+    active--;
+}
+
+bool startSource(const std::string &spec, TrackTable &table, ScannerRegistry &reg,
+                 size_t batchSize, std::atomic<int> &active) {
+    size_t colon = spec.find(':');
+    if (colon == std::string::npos) return false;
+    std::string kind = spec.substr(0, colon), arg = spec.substr(colon + 1);
+
+    int fd = -1;
+    bool closeFd = true;
+    if (kind == "file") {
+        if (arg == "-") { fd = STDIN_FILENO; closeFd = false; }
+        else fd = open(arg.c_str(), O_RDONLY);
+    } else if (kind == "serial") {
+        fd = openSerial(arg.c_str());
+    } else if (kind == "tcp") {
+        fd = connectTcp(arg);
+    } else if (kind == "listen") {
+        int lfd = listenTcp(atoi(arg.c_str()));
+        if (lfd < 0) { perror(spec.c_str()); return false; }
+        active++;
+        std::thread([lfd, &table, &reg, batchSize, &active] {
+            for (;;) {
+                struct sockaddr_storage peer;
+                socklen_t plen = sizeof(peer);
+                int cfd = accept(lfd, (struct sockaddr *)&peer, &plen);
+                if (cfd < 0) {
+                    // EMFILE/ENFILE 等持续性错误时退避，避免空转占满一个核
+                    if (errno != EINTR && errno != ECONNABORTED) {
+                        perror("accept");
+                        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+                    }
+                    continue;
+                }
+                // 重连时源端口会变，只用对端地址作为扫描器名
+                char host[NI_MAXHOST];
+                getnameinfo((struct sockaddr *)&peer, plen, host, sizeof(host), nullptr, 0,
+                            NI_NUMERICHOST);
+                uint16_t id = reg.acquire(std::string("tcp:") + host);
+                active++;
+                std::thread(runReader, cfd, id, std::ref(table), std::ref(reg), batchSize,
+                            std::ref(active), true).detach();
+            }
+        }).detach();
+        return true;
+    } else {
+        return false;
+    }
+    if (fd < 0) { perror(spec.c_str()); return false; }
+
+    uint16_t id = reg.acquire(spec);
+    active++;
+    std::thread(runReader, fd, id, std::ref(table), std::ref(reg), batchSize, std::ref(active),
+                closeFd).detach();
+    return true;
+}
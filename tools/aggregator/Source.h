@@ -0,0 +1,37 @@
+#ifndef AGG_SOURCE_H
+#define AGG_SOURCE_H
+
+#include "TrackTable.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// === 扫描器登记 ===
+// 每个输入流 (串口/文件/连接) 对应一个扫描器编号。
+// 同名扫描器断线重连时复用原编号 (同名且仍在线时才分配新编号)，
+// 避免同一台设备在 RSSI 列表里出现多次。
+class ScannerRegistry {
+public:
+    uint16_t acquire(const std::string &name);
+    void release(uint16_t id);
+    std::string name(uint16_t id);
+    size_t size();
+private:
+    std::mutex mu;
+    std::vector<std::string> names;
+    std::vector<bool> online;
+};
+
+// === 输入源 ===
+// spec 格式:
+//   file:<path>      读取文件直到结尾 ("file:-" 为标准输入)
+//   serial:<dev>     串口 (如 /dev/ttyACM0)
+//   tcp:<host>:<port>  主动连接 (如 ser2net 转发的扫描器)
+//   listen:<port>    监听端口，每个连入的连接视为一个扫描器
+// 每个源在独立线程中读取，解析后经 BatchRouter 投递到航迹表。
+// active 记录仍在读取的源数量 (listen 源永不结束)。
+bool startSource(const std::string &spec, TrackTable &table, ScannerRegistry &reg,
+                 size_t batchSize, std::atomic<int> &active);
+
+#endif
@@ -0,0 +1,318 @@
+#include "TrackTable.h"
+#include <cmath>
+#include <stdio.h>
+#include <string.h>
+
+#define RSSI_EWMA 0.25f
+
+// === 延迟直方图 ===
+static int bucketOf(uint64_t ns) {
+    double us = ns / 1000.0;
+    if (us < 1.0) return 0;
+    int b = (int)(std::log2(us) * 4.0) + 1;
+    return b;
+}
+
+void LatencyHist::add(uint64_t ns) {
+    int b = bucketOf(ns);
+    if (b >= kBuckets) b = kBuckets - 1;
+    buckets[b]++;
+    total++;
+}
+
+void LatencyHist::merge(const LatencyHist &o) {
+    for (int i = 0; i < kBuckets; i++) buckets[i] += o.buckets[i];
+    total += o.total;
+}
+
+// 返回所在桶的上界
+double LatencyHist::percentileUs(double p) const {
+    if (total == 0) return 0;
+    uint64_t target = (uint64_t)std::ceil(total * p);
+    uint64_t acc = 0;
+    for (int i = 0; i < kBuckets; i++) {
+        acc += buckets[i];
+        if (acc >= target) return std::exp2(i / 4.0);
+    }
+    return std::exp2((kBuckets - 1) / 4.0);
+}
+
+void LatencyHist::reset() {
+    memset(buckets, 0, sizeof(buckets));
+    total = 0;
+}
+
+// === 航迹表 ===
+TrackTable::TrackTable(int shardCount, size_t maxQueued) : maxQueued(maxQueued) {
+    if (shardCount < 1) shardCount = 1;
+    for (int i = 0; i < shardCount; i++) shards.emplace_back(new Shard());
+    for (auto &s : shards) {
+        Shard *sp = s.get();
+        sp->worker = std::thread([this, sp] { workerLoop(*sp); });
+    }
+}
+
+TrackTable::~TrackTable() {
+    stopping = true;
+    for (auto &s : shards) {
+        std::lock_guard<std::mutex> lk(s->qMu);
+        s->qCv.notify_all();
+    }
+    for (auto &s : shards) s->worker.join();
+}
+
+// FNV-1a
+int TrackTable::shardOf(const char *key) const {
+    uint32_t h = 2166136261u;
+    for (const char *p = key; *p; p++) { h ^= (uint8_t)*p; h *= 16777619u; }
+    return (int)(h % shards.size());
+}
+
+bool TrackTable::lookupAlias(const char *mac, char *sn, size_t size) {
+    std::shared_lock<std::shared_mutex> lk(aliasMu);
+    auto it = snOfMac.find(mac);
+    if (it == snOfMac.end()) return false;
+    snprintf(sn, size, "%s", it->second.c_str());
+    return true;
+}
+
+void TrackTable::learnAlias(const char *mac, const char *sn) {
+    std::unique_lock<std::shared_mutex> lk(aliasMu);
+    snOfMac[mac] = sn;
+}
+
+void TrackTable::push(int shard, std::vector<Report> &&batch) {
+    Shard &s = *shards[shard];
+    std::unique_lock<std::mutex> lk(s.qMu);
+    s.spaceCv.wait(lk, [&] { return s.queue.size() < maxQueued; });
+    s.queue.push_back(std::move(batch));
+    s.pending++;
+    s.qCv.notify_one();
+}
+
+void TrackTable::drain() {
+    for (auto &s : shards) {
+        std::unique_lock<std::mutex> lk(s->qMu);
+        s->idleCv.wait(lk, [&] { return s->pending == 0; });
+    }
+}
+
+void TrackTable::workerLoop(Shard &s) {
+    std::deque<std::vector<Report>> work;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(s.qMu);
+            s.qCv.wait(lk, [&] { return !s.queue.empty() || stopping; });
+            if (s.queue.empty()) return;
+            work.swap(s.queue);
+            s.spaceCv.notify_all();
+        }
+        size_t n = work.size();
+        {
+            std::lock_guard<std::mutex> lk(s.tableMu);
+            for (auto &batch : work) {
+                for (auto &r : batch)
+                    apply(findOrCreate(s, r.sn[0] ? r.sn : r.mac, r.rxNs), r);
+                s.reports += batch.size();
+            }
+            // 整批合并完成的时刻作为端到端延迟的终点
+            uint64_t done = nowNs();
+            for (auto &batch : work)
+                for (auto &r : batch) s.latency.add(done - r.rxNs);
+        }
+        work.clear();
+        {
+            std::lock_guard<std::mutex> lk(s.qMu);
+            s.pending -= n;
+            if (s.pending == 0) s.idleCv.notify_all();
+        }
+    }
+}
+
+Track &TrackTable::findOrCreate(Shard &s, const std::string &key, uint64_t ns) {
+    auto it = s.tracks.find(key);
+    if (it == s.tracks.end()) {
+        it = s.tracks.emplace(key, Track()).first;
+        it->second.key = key;
+        it->second.firstNs = ns;
+    }
+    return it->second;
+}
+
+// 合并规则与固件一致: 0 表示该字段尚未收到，不覆盖已有值；序列号长度优先
+void TrackTable::apply(Track &t, const Report &r) {
+    if (r.sn[0] && strlen(r.sn) >= t.sn.size()) t.sn = r.sn;
+    t.phyMask |= (r.phy == 5) ? PHY_BLE5 : PHY_BLE4;
+    bool knownMac = false;
+    for (auto &m : t.macs) if (m == r.mac) { knownMac = true; break; }
+    if (!knownMac) t.macs.push_back(r.mac);
+    if (r.lat != 0) {
+        t.lat = r.lat; t.lon = r.lon;
+        t.alt = r.alt; t.height = r.height;
+        t.speed_h = r.speed_h; t.speed_v = r.speed_v; t.dir = r.dir;
+    }
+    if (r.op_lat != 0) { t.op_lat = r.op_lat; t.op_lon = r.op_lon; }
+    if (r.rxNs > t.lastNs) t.lastNs = r.rxNs;
+    t.msgCount++;
+
+    for (auto &sc : t.scanners) {
+        if (sc.scanner != r.scanner) continue;
+        sc.rssi = r.rssi;
+        sc.rssiAvg += RSSI_EWMA * (r.rssi - sc.rssiAvg);
+        sc.count++;
+        sc.lastNs = r.rxNs;
+        return;
+    }
+    t.scanners.push_back({r.scanner, r.rssi, (float)r.rssi, 1, r.rxNs});
+}
+
+void TrackTable::mergeTrack(Track &dst, const Track &src) {
+    if (src.sn.size() > dst.sn.size()) dst.sn = src.sn;
+    for (auto &m : src.macs) {
+        bool known = false;
+        for (auto &d : dst.macs) if (d == m) { known = true; break; }
+        if (!known) dst.macs.push_back(m);
+    }
+    dst.phyMask |= src.phyMask;
+    if (src.lastNs > dst.lastNs) {
+        if (src.lat != 0) {
+            dst.lat = src.lat; dst.lon = src.lon;
+            dst.alt = src.alt; dst.height = src.height;
+            dst.speed_h = src.speed_h; dst.speed_v = src.speed_v; dst.dir = src.dir;
+        }
+        dst.lastNs = src.lastNs;
+    }
+    if (dst.op_lat == 0) { dst.op_lat = src.op_lat; dst.op_lon = src.op_lon; }
+    if (dst.lat == 0) {
+        dst.lat = src.lat; dst.lon = src.lon;
+        dst.alt = src.alt; dst.height = src.height;
+        dst.speed_h = src.speed_h; dst.speed_v = src.speed_v; dst.dir = src.dir;
+    }
+    if (src.firstNs < dst.firstNs) dst.firstNs = src.firstNs;
+    dst.msgCount += src.msgCount;
+    for (auto &sc : src.scanners) {
+        bool found = false;
+        for (auto &d : dst.scanners) {
+            if (d.scanner != sc.scanner) continue;
+            if (sc.lastNs > d.lastNs) { d.rssi = sc.rssi; d.rssiAvg = sc.rssiAvg; d.lastNs = sc.lastNs; }
+            d.count += sc.count;
+            found = true;
+            break;
+        }
+        if (!found) dst.scanners.push_back(sc);
+    }
+}
+
+void TrackTable::mergeAliases() {
+    // 第一步: 逐分片摘出已有别名的 MAC 航迹 (sn 为空说明它是按 MAC 建的)
+    std::vector<std::pair<std::string, Track>> orphans;
+    char sn[sizeof(Report::sn)];
+    for (auto &s : shards) {
+        std::lock_guard<std::mutex> lk(s->tableMu);
+        for (auto it = s->tracks.begin(); it != s->tracks.end(); ) {
+            if (it->second.sn.empty() && lookupAlias(it->first.c_str(), sn, sizeof(sn))) {
+                orphans.emplace_back(sn, std::move(it->second));
+                it = s->tracks.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    // 第二步: 并入目标分片，同一时刻只持有一把分片锁
+    for (auto &o : orphans) {
+        Shard &s = *shards[shardOf(o.first.c_str())];
+        std::lock_guard<std::mutex> lk(s.tableMu);
+        Track &t = findOrCreate(s, o.first, o.second.firstNs);
+        // 目标航迹可能是刚建的 (带 sn 的报文还在队列里)，孤儿自身 sn 为空
+        if (t.sn.empty()) t.sn = o.first;
+        mergeTrack(t, o.second);
+    }
+}
+
+// 用 "lastNs + maxAge < now" 比较: 采集线程可能在 now 之后才更新 lastNs，
+// 写成 now - lastNs 会在无符号下回绕成极大值
+void TrackTable::expire(uint64_t now, uint64_t maxAgeNs) {
+    std::vector<std::string> deadMacs;
+    for (auto &s : shards) {
+        std::lock_guard<std::mutex> lk(s->tableMu);
+        for (auto it = s->tracks.begin(); it != s->tracks.end(); ) {
+            Track &t = it->second;
+            if (t.lastNs + maxAgeNs < now) {
+                deadMacs.insert(deadMacs.end(), t.macs.begin(), t.macs.end());
+                it = s->tracks.erase(it);
+                continue;
+            }
+            auto &sc = t.scanners;
+            for (size_t i = 0; i < sc.size(); ) {
+                if (sc[i].lastNs + maxAgeNs < now) { sc[i] = sc.back(); sc.pop_back(); }
+                else i++;
+            }
+            ++it;
+        }
+    }
+    if (deadMacs.empty()) return;
+    std::unique_lock<std::shared_mutex> lk(aliasMu);
+    for (auto &m : deadMacs) snOfMac.erase(m);
+    aliasGen.fetch_add(1, std::memory_order_release);
+}
+
+void TrackTable::forEach(const std::function<void(const Track &)> &fn) {
+    for (auto &s : shards) {
+        std::lock_guard<std::mutex> lk(s->tableMu);
+        for (auto &kv : s->tracks) fn(kv.second);
+    }
+}
+
+TrackTable::Stats TrackTable::stats(bool reset) {
+    Stats st = {0, 0, 0, 0};
+    LatencyHist all;
+    for (auto &s : shards) {
+        std::lock_guard<std::mutex> lk(s->tableMu);
+        st.reports += s->reports;
+        st.tracks += s->tracks.size();
+        all.merge(s->latency);
+        if (reset) { s->reports = 0; s->latency.reset(); }
+    }
+    st.p50Us = all.percentileUs(0.50);
+    st.p99Us = all.percentileUs(0.99);
+    return st;
+}
+
+// === 批次路由 ===
+BatchRouter::BatchRouter(TrackTable &table, size_t batchSize)
+    : table(table), batchSize(batchSize), pending(table.shardCount()) {
+    for (auto &p : pending) p.reserve(batchSize);
+}
+
+void BatchRouter::add(Report r) {
+    // 别名表删过条目 (航迹超时) 后本地缓存作废，同时限制缓存只保留存活期内的地址
+    uint64_t gen = table.aliasGeneration();
+    if (gen != knownGen) { known.clear(); knownGen = gen; }
+    if (r.sn[0]) {
+        // 只在本线程第一次看到该对应关系时写全局别名表
+        auto it = known.find(r.mac);
+        if (it == known.end() || it->second != r.sn) {
+            known[r.mac] = r.sn;
+            table.learnAlias(r.mac, r.sn);
+        }
+    } else {
+        table.lookupAlias(r.mac, r.sn, sizeof(r.sn));
+    }
+    int shard = table.shardOf(r.sn[0] ? r.sn : r.mac);
+    auto &p = pending[shard];
+    p.push_back(r);
+    if (p.size() >= batchSize) {
+        table.push(shard, std::move(p));
+        p = std::vector<Report>();
+        p.reserve(batchSize);
+    }
+}
+
+void BatchRouter::flush() {
+    for (int i = 0; i < (int)pending.size(); i++) {
+        if (pending[i].empty()) continue;
+        table.push(i, std::move(pending[i]));
+        pending[i] = std::vector<Report>();
+        pending[i].reserve(batchSize);
+    }
+}
@@ -0,0 +1,149 @@
+#ifndef AGG_TRACK_TABLE_H
+#define AGG_TRACK_TABLE_H
+
+#include "Report.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// === 全局航迹表 ===
+// 按航迹键哈希分片，每个分片由一个工作线程独占写入:
+// 采集线程把报文按分片攒成批次投递，工作线程整批合并，分片之间没有共享锁。
+//
+// 航迹键: 已知 UAS ID (sn) 时用 sn，否则用 MAC。
+// 同一架无人机在 BLE 4 与 BLE 5 上通常使用不同的广播地址，只有 sn 能把它们合成一条。
+// 表里维护一张 MAC -> sn 别名表: 采集线程遇到不带 sn 的报文时先查别名，
+// 查到就按 sn 路由；别名出现之前已经按 MAC 建立的航迹由 mergeAliases() 定期并入。
+
+// 每个扫描器对该航迹的信号强度 (用于粗略定位)
+struct ScannerRssi {
+    uint16_t scanner;
+    int8_t rssi;        // 最近一次
+    float rssiAvg;      // 指数平滑
+    uint32_t count;
+    uint64_t lastNs;
+};
+
+#define PHY_BLE4 0x01
+#define PHY_BLE5 0x02
+
+struct Track {
+    std::string key;               // sn 或 MAC
+    std::string sn;
+    std::vector<std::string> macs; // 该无人机用过的所有广播地址
+    uint8_t phyMask = 0;           // PHY_BLE4 / PHY_BLE5
+    double lat = 0, lon = 0;
+    double op_lat = 0, op_lon = 0;
+    int alt = 0, height = 0;
+    int speed_h = 0, speed_v = 0, dir = 0;
+    uint64_t firstNs = 0, lastNs = 0;
+    uint32_t msgCount = 0;
+    std::vector<ScannerRssi> scanners;
+};
+
+// 端到端延迟直方图: 每个二倍程 4 个桶 (单位 us)
+class LatencyHist {
+public:
+    void add(uint64_t ns);
+    void merge(const LatencyHist &o);
+    double percentileUs(double p) const;
+    uint64_t count() const { return total; }
+    void reset();
+private:
+    static const int kBuckets = 160;
+    uint64_t buckets[kBuckets] = {};
+    uint64_t total = 0;
+};
+
+class TrackTable {
+public:
+    // maxQueued: 每个分片最多积压的批次数，满了 push() 阻塞 (背压)
+    explicit TrackTable(int shards, size_t maxQueued = 256);
+    ~TrackTable();
+
+    int shardCount() const { return (int)shards.size(); }
+    int shardOf(const char *key) const;
+
+    // MAC -> sn 别名 (采集线程调用)
+    bool lookupAlias(const char *mac, char *sn, size_t size);
+    void learnAlias(const char *mac, const char *sn);
+    // 别名表有删除时递增，采集线程据此清空本地缓存
+    uint64_t aliasGeneration() const { return aliasGen.load(std::memory_order_acquire); }
+
+    // 把已有别名的 MAC 航迹并入对应的 sn 航迹
+    void mergeAliases();
+
+    void push(int shard, std::vector<Report> &&batch);
+
+    // 等待所有已投递的批次合并完成
+    void drain();
+
+    // 删除超过 maxAgeNs 未更新的航迹，以及航迹里超时的扫描器 RSSI
+    void expire(uint64_t now, uint64_t maxAgeNs);
+
+    // 逐分片加锁遍历
+    void forEach(const std::function<void(const Track &)> &fn);
+
+    struct Stats {
+        uint64_t reports;   // 自上次 reset 以来合并的报文数
+        size_t tracks;
+        double p50Us, p99Us;
+    };
+    Stats stats(bool reset);
+
+private:
+    struct Shard {
+        std::mutex qMu;
+        std::condition_variable qCv;     // 有新批次 / 要求停止
+        std::condition_variable spaceCv; // 队列有空位
+        std::condition_variable idleCv;  // 队列清空且合并完成
+        std::deque<std::vector<Report>> queue;
+        size_t pending = 0;              // 已投递但未合并完的批次
+
+        std::mutex tableMu;              // 只与 forEach/expire/stats 竞争
+        std::unordered_map<std::string, Track> tracks;
+        LatencyHist latency;
+        uint64_t reports = 0;
+
+        std::thread worker;
+    };
+
+    void workerLoop(Shard &s);
+    static Track &findOrCreate(Shard &s, const std::string &key, uint64_t ns);
+    static void apply(Track &t, const Report &r);
+    static void mergeTrack(Track &dst, const Track &src);
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t maxQueued;
+    std::atomic<bool> stopping{false};
+
+    std::shared_mutex aliasMu;
+    std::unordered_map<std::string, std::string> snOfMac;
+    std::atomic<uint64_t> aliasGen{0};
+};
+
+// === 批次路由 (每个采集线程一个) ===
+// 把报文按分片暂存，攒够 batchSize 或调用 flush() 时整批投递
+class BatchRouter {
+public:
+    BatchRouter(TrackTable &table, size_t batchSize);
+    ~BatchRouter() { flush(); }
+    void add(Report r);
+    void flush();
+private:
+    TrackTable &table;
+    size_t batchSize;
+    std::vector<std::vector<Report>> pending;
+    std::unordered_map<std::string, std::string> known; // 本线程已登记过的别名
+    uint64_t knownGen = 0;                              // known 对应的别名表版本
+};
+
+#endif
@@ -0,0 +1,120 @@
+/*
+ * OpenDroneID 多扫描器聚合守护进程
+ * ------------------------------------------------
+ * 从多个无屏扫描器 (固件 headless 版本) 的串口流读取 "$ODID" 行，
+ * 合并成一张全局航迹表，并给出每架无人机在各扫描器上的 RSSI。
+ *
+ * 用法: odid_aggd [-t 线程] [-b 批大小] [-i 输出周期s] [-v] <源> [<源> ...]
+ *   源: file:<path> | serial:<dev> | tcp:<host>:<port> | listen:<port>
+ *
+ * 输出 (标准输出):
+ *   #AGG,<秒>,<航迹数>,<reports/s>,<p50 us>,<p99 us>
+ *   TRACK,<键>,<sn>,<mac>/<mac>...,<phy 4|5|4+5>,<lat>,<lon>,<alt>,<speed_h>,<dir>,<age ms>,
+ *         <扫描器>:<rssi>|...   (-v，只列出 TRACK_TIMEOUT_S 内仍收到该机的扫描器)
+ */
+
+#include "Report.h"
+#include "Source.h"
+#include "TrackTable.h"
+#include <atomic>
+#include <chrono>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <unistd.h>
+
+#define TRACK_TIMEOUT_S 20   // 与固件一致: 20 秒未更新则移除
+
+static std::atomic<bool> quit(false);
+
+static void onSignal(int) { quit = true; }
+
+static void usage() {
+    fprintf(stderr,
+            "usage: odid_aggd [-t threads] [-b batch] [-i interval_s] [-v] <source>...\n"
+            "  source: file:<path> | file:- | serial:<dev> | tcp:<host>:<port> | listen:<port>\n");
+    exit(2);
+}
+
+// 采集线程可能在 now 之后才更新 lastNs，此时年龄按 0 计
+static uint64_t ageNs(uint64_t now, uint64_t lastNs) {
+    return lastNs > now ? 0 : now - lastNs;
+}
+
+static void dumpTracks(TrackTable &table, ScannerRegistry &reg, uint64_t now) {
+    const uint64_t timeoutNs = (uint64_t)TRACK_TIMEOUT_S * 1000000000ull;
+    table.forEach([&](const Track &t) {
+        printf("TRACK,%s,%s,", t.key.c_str(), t.sn.c_str());
+        for (size_t i = 0; i < t.macs.size(); i++) printf("%s%s", i ? "/" : "", t.macs[i].c_str());
+        const char *phy = (t.phyMask == (PHY_BLE4 | PHY_BLE5)) ? "4+5"
+                        : (t.phyMask & PHY_BLE5) ? "5" : "4";
+        printf(",%s,%.7f,%.7f,%d,%d,%d,%llu,", phy, t.lat, t.lon, t.alt, t.speed_h, t.dir,
+               (unsigned long long)(ageNs(now, t.lastNs) / 1000000));
+        bool first = true;
+        for (const ScannerRssi &sc : t.scanners) {
+            if (ageNs(now, sc.lastNs) > timeoutNs) continue;
+            printf("%s%s:%.1f", first ? "" : "|", reg.name(sc.scanner).c_str(), sc.rssiAvg);
+            first = false;
+        }
+        printf("\n");
+    });
+}
+
+int main(int argc, char **argv) {
+    int threads = (int)std::thread::hardware_concurrency();
+    size_t batch = 64;
+    double interval = 1.0;
+    bool verbose = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "t:b:i:v")) != -1) {
+        switch (opt) {
+            case 't': threads = atoi(optarg); break;
+            case 'b': batch = (size_t)atoi(optarg); break;
+            case 'i': interval = atof(optarg); break;
+            case 'v': verbose = true; break;
+            default: usage();
+        }
+    }
+    if (optind >= argc || threads < 1 || batch < 1 || interval <= 0) usage();
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    TrackTable table(threads);
+    ScannerRegistry reg;
+    std::atomic<int> active(0);
+    for (int i = optind; i < argc; i++) {
+        if (!startSource(argv[i], table, reg, batch, active)) {
+            fprintf(stderr, "bad source: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    uint64_t t0 = nowNs(), last = t0;
+    uint64_t intervalNs = (uint64_t)(interval * 1e9);
+    for (;;) {
+        bool done = quit || active == 0;
+        if (done) table.drain();
+        uint64_t now = nowNs();
+        if (done || now - last >= intervalNs) {
+            table.mergeAliases();
+            TrackTable::Stats st = table.stats(true);
+            double secs = (now - last) / 1e9;
+            printf("#AGG,%.1f,%zu,%.0f,%.1f,%.1f\n", (now - t0) / 1e9, st.tracks,
+                   secs > 0 ? st.reports / secs : 0.0, st.p50Us, st.p99Us);
+            if (verbose) dumpTracks(table, reg, now);
+            fflush(stdout);
+            if (!done) table.expire(now, (uint64_t)TRACK_TIMEOUT_S * 1000000000ull);
+            last = now;
+        }
+        if (done) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    // 读取线程可能仍阻塞在 read() 上，直接退出
+    fflush(stdout);
+    _exit(0);
+}
@@ -0,0 +1,256 @@
+/*
+ * 聚合负载生成器 / 基准测试
+ * ------------------------------------------------
+ * 在 2km x 2km 场地上网格布置若干扫描器，随机撒下大量无人机，
+ * 每架无人机只被半径 RANGE_M 内的扫描器看到，RSSI 按对数距离模型生成。
+ * 无人机按编号交替使用 BLE 4 / BLE 5；每 4 架中有 1 架同时在另一个 PHY 上用第二个地址广播，
+ * 且第二个地址在第一个时间步里还没有 sn，用来检验聚合端按 UAS ID 合并。
+ *
+ * 基准模式 (默认): 预生成各扫描器的 "$ODID" 行，每个扫描器一个采集线程
+ *   按 odid_aggd 同样的路径 (分块 -> 解析 -> BatchRouter -> TrackTable) 全速灌入，
+ *   对每个工作线程数输出合并吞吐与端到端延迟。
+ * 输出模式 (-e K): 以实时节奏把第 K 个扫描器的报文流写到标准输出，
+ *   可以用管道或 socat/nc 喂给 odid_aggd。
+ *
+ *   -R: 限制每个扫描器每秒灌入的报文数 (0 = 全速)。全速时队列处于背压状态，
+ *       延迟主要是排队时间；限速到低于饱和吞吐时测到的才是正常负载下的端到端延迟。
+ *
+ * 用法: odid_loadgen [-s 扫描器] [-d 无人机] [-T 1,2,4,8] [-b 批大小] [-D 秒] [-R 每扫描器报文/s]
+ *       odid_loadgen [-s 扫描器] [-d 无人机] -e K [-r Hz]
+ */
+
+#include "Report.h"
+#include "TrackTable.h"
+#include <atomic>
+#include <chrono>
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#define SITE_M      2000.0   // 场地边长
+#define RANGE_M     800.0    // 扫描器接收半径
+#define ORIGIN_LAT  31.2304
+#define ORIGIN_LON  121.4737
+#define M_PER_DEG   111320.0
+
+struct SimDrone {
+    char mac[18];
+    char mac2[18];       // 第二个 PHY 上的地址 (dual 时有效)
+    char sn[21];
+    uint8_t phy;
+    bool dual;
+    double x, y, alt;    // 场地坐标 (米)
+    double vx, vy;
+    double opX, opY;
+};
+
+struct SimScanner {
+    double x, y;
+};
+
+static void makeSite(int nScanners, int nDrones, std::vector<SimScanner> &scanners,
+                     std::vector<SimDrone> &drones) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> pos(0, SITE_M), vel(-15, 15), hgt(20, 120);
+
+    int side = (int)ceil(sqrt((double)nScanners));
+    for (int i = 0; i < nScanners; i++) {
+        double step = SITE_M / side;
+        scanners.push_back({(i % side + 0.5) * step, (i / side + 0.5) * step});
+    }
+    for (int i = 0; i < nDrones; i++) {
+        SimDrone d;
+        snprintf(d.mac, sizeof(d.mac), "%02X:%02X:%02X:%02X:%02X:%02X",
+                 0x60, (i >> 24) & 0xFF, (i >> 16) & 0xFF, (i >> 8) & 0xFF, i & 0xFF, 0x01);
+        snprintf(d.mac2, sizeof(d.mac2), "%02X:%02X:%02X:%02X:%02X:%02X",
+                 0x60, (i >> 24) & 0xFF, (i >> 16) & 0xFF, (i >> 8) & 0xFF, i & 0xFF, 0x02);
+        snprintf(d.sn, sizeof(d.sn), "1581F%015d", i);
+        d.phy = (i % 2) ? 5 : 4;
+        d.dual = (i % 4) == 3;
+        d.x = pos(rng); d.y = pos(rng); d.alt = hgt(rng);
+        d.vx = vel(rng); d.vy = vel(rng);
+        d.opX = pos(rng); d.opY = pos(rng);
+        drones.push_back(d);
+    }
+}
+
+// 生成扫描器 s 在时刻 t (秒) 看到的所有报文行
+static void genLines(const SimScanner &s, uint16_t id, const std::vector<SimDrone> &drones,
+                     double t, std::mt19937 &rng, std::string &out) {
+    std::normal_distribution<double> noise(0, 3);
+    char line[256];
+    for (const SimDrone &d : drones) {
+        double x = fmod(d.x + d.vx * t + 10 * SITE_M, SITE_M);
+        double y = fmod(d.y + d.vy * t + 10 * SITE_M, SITE_M);
+        double dist = hypot(x - s.x, y - s.y);
+        if (dist > RANGE_M) continue;
+
+        Report r = {};
+        r.scanner = id;
+        r.phy = d.phy;
+        r.typeMask = 0x13; // Basic ID + Location + System
+        r.rssi = (int8_t)fmax(-100, -40 - 20 * log10(fmax(dist, 1.0)) + noise(rng));
+        memcpy(r.mac, d.mac, sizeof(r.mac));
+        memcpy(r.sn, d.sn, sizeof(r.sn));
+        r.lat = ORIGIN_LAT + y / M_PER_DEG;
+        r.lon = ORIGIN_LON + x / (M_PER_DEG * cos(ORIGIN_LAT * M_PI / 180));
+        r.alt = (int16_t)d.alt; r.height = (int16_t)d.alt;
+        r.speed_h = (int16_t)hypot(d.vx, d.vy); r.speed_v = 0;
+        r.dir = (int16_t)fmod(atan2(d.vx, d.vy) * 180 / M_PI + 360, 360);
+        r.op_lat = ORIGIN_LAT + d.opY / M_PER_DEG;
+        r.op_lon = ORIGIN_LON + d.opX / (M_PER_DEG * cos(ORIGIN_LAT * M_PI / 180));
+        int n = formatReport(r, (uint32_t)(t * 1000), line, sizeof(line));
+        out.append(line, n);
+
+        if (d.dual) {
+            memcpy(r.mac, d.mac2, sizeof(r.mac));
+            r.phy = (d.phy == 5) ? 4 : 5;
+            if (t < 1) r.sn[0] = 0;
+            n = formatReport(r, (uint32_t)(t * 1000), line, sizeof(line));
+            out.append(line, n);
+        }
+    }
+}
+
+// === 输出模式 ===
+static void emit(int k, const std::vector<SimScanner> &scanners,
+                 const std::vector<SimDrone> &drones, double hz) {
+    std::mt19937 rng(1000 + k);
+    auto start = std::chrono::steady_clock::now();
+    std::string buf;
+    for (long tick = 0; ; tick++) {
+        double t = tick / hz;
+        buf.clear();
+        genLines(scanners[k], (uint16_t)k, drones, t, rng, buf);
+        if (fwrite(buf.data(), 1, buf.size(), stdout) != buf.size()) return;
+        fflush(stdout);
+        std::this_thread::sleep_until(start + std::chrono::microseconds((long)((tick + 1) * 1e6 / hz)));
+    }
+}
+
+// === 基准模式 ===
+// 与 odid_aggd 的 readLoop 相同: 按 16KB 块切行、解析、路由，每块 flush 一次
+static void feed(const std::string &data, uint16_t scanner, TrackTable &table, size_t batch,
+                 double rate, std::atomic<bool> &stop) {
+    BatchRouter router(table, batch);
+    Report r;
+    r.scanner = scanner;
+    // 限速时按较小的块切，避免一块内的报文共用时间戳拉高延迟
+    const size_t chunk = rate > 0 ? 2048 : 16384;
+    uint64_t start = nowNs(), sent = 0;
+    while (!stop) {
+        size_t pos = 0;
+        while (pos < data.size() && !stop) {
+            size_t end = pos + chunk < data.size() ? pos + chunk : data.size();
+            const char *nl = (const char *)memrchr(data.data() + pos, '\n', end - pos);
+            end = nl ? (size_t)(nl - data.data()) + 1 : data.size();
+            r.rxNs = nowNs();
+            while (pos < end) {
+                const char *e = (const char *)memchr(data.data() + pos, '\n', end - pos);
+                size_t len = e - (data.data() + pos);
+                if (parseReport(data.data() + pos, len, &r)) { router.add(r); sent++; }
+                pos += len + 1;
+            }
+            router.flush();
+            if (rate > 0) {
+                uint64_t due = start + (uint64_t)(sent / rate * 1e9);
+                uint64_t now = nowNs();
+                if (due > now) std::this_thread::sleep_for(std::chrono::nanoseconds(due - now));
+            }
+        }
+    }
+}
+
+static void bench(const std::vector<SimScanner> &scanners, const std::vector<SimDrone> &drones,
+                  const std::vector<int> &threadCounts, size_t batch, double seconds,
+                  double rate) {
+    // 每个扫描器预生成 10 个时间步，基准只测聚合端，不测生成
+    std::vector<std::string> data(scanners.size());
+    size_t lines = 0;
+    for (size_t k = 0; k < scanners.size(); k++) {
+        std::mt19937 rng(1000 + k);
+        for (int step = 0; step < 10; step++)
+            genLines(scanners[k], (uint16_t)k, drones, step, rng, data[k]);
+        for (char c : data[k]) lines += (c == '\n');
+    }
+    printf("# scanners=%zu drones=%zu batch=%zu lines/pass=%zu rate/scanner=%s hw_threads=%u\n",
+           scanners.size(), drones.size(), batch, lines,
+           rate > 0 ? std::to_string((long)rate).c_str() : "max",
+           std::thread::hardware_concurrency());
+    printf("%-8s %14s %10s %10s %8s\n", "workers", "reports/s", "p50_us", "p99_us", "tracks");
+
+    for (int n : threadCounts) {
+        TrackTable table(n);
+        std::atomic<bool> stop(false);
+        std::vector<std::thread> feeders;
+        uint64_t t0 = nowNs();
+        for (size_t k = 0; k < scanners.size(); k++)
+            feeders.emplace_back(feed, std::cref(data[k]), (uint16_t)k, std::ref(table), batch,
+                                 rate, std::ref(stop));
+        std::this_thread::sleep_for(std::chrono::milliseconds((long)(seconds * 1000)));
+        stop = true;
+        for (auto &f : feeders) f.join();
+        table.drain();
+        double secs = (nowNs() - t0) / 1e9;
+        table.mergeAliases(); // 航迹数应等于无人机数
+        TrackTable::Stats st = table.stats(false);
+        printf("%-8d %14.0f %10.1f %10.1f %8zu\n", n, st.reports / secs, st.p50Us, st.p99Us,
+               st.tracks);
+        fflush(stdout);
+    }
+}
+
+static std::vector<int> parseList(const char *s) {
+    std::vector<int> v;
+    for (const char *p = s; *p; ) {
+        v.push_back(atoi(p));
+        const char *c = strchr(p, ',');
+        if (!c) break;
+        p = c + 1;
+    }
+    return v;
+}
+
+int main(int argc, char **argv) {
+    int nScanners = 32, nDrones = 2000, emitScanner = -1;
+    size_t batch = 64;
+    double seconds = 3, hz = 5, rate = 0;
+    std::vector<int> threadCounts = {1, 2, 4, 8};
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:d:T:b:D:e:r:R:")) != -1) {
+        switch (opt) {
+            case 's': nScanners = atoi(optarg); break;
+            case 'd': nDrones = atoi(optarg); break;
+            case 'T': threadCounts = parseList(optarg); break;
+            case 'b': batch = (size_t)atoi(optarg); break;
+            case 'D': seconds = atof(optarg); break;
+            case 'e': emitScanner = atoi(optarg); break;
+            case 'r': hz = atof(optarg); break;
+            case 'R': rate = atof(optarg); break;
+            default:
+                fprintf(stderr, "usage: odid_loadgen [-s scanners] [-d drones] [-T 1,2,4,8] "
+                                "[-b batch] [-D seconds] [-R rate] [-e scanner] [-r hz]\n");
+                return 2;
+        }
+    }
+    if (nScanners < 1 || nDrones < 1 || batch < 1 || hz <= 0 ||
+        rate < 0 || emitScanner >= nScanners || threadCounts.empty()) {
+        fprintf(stderr, "bad arguments\n");
+        return 2;
+    }
+
+    std::vector<SimScanner> scanners;
+    std::vector<SimDrone> drones;
+    makeSite(nScanners, nDrones, scanners, drones);
+
+    if (emitScanner >= 0) emit(emitScanner, scanners, drones, hz);
+    else bench(scanners, drones, threadCounts, batch, seconds, rate);
+    return 0;
+}